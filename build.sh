@@ -10,23 +10,32 @@ else
     echo "✅ FLTK library is already installed."
 fi
 
-# 2. Check if main.cpp exists
-if [ ! -f "main.cpp" ]; then
-    echo "❌ Error: main.cpp not found in the current directory."
+# 2. Check if the sources exist
+if [ ! -f "CMakeLists.txt" ] || [ ! -f "ehr_core.cpp" ]; then
+    echo "❌ Error: CMakeLists.txt / ehr_core.cpp not found in the current directory."
     exit 1
 fi
 
-# 3. Compile the code
-echo "🔨 Compiling main.cpp..."
-g++ ehr_gui.cpp -lfltk -o ehr_gui
+# 3. Compile the core library, both front ends and the benchmark (-O2 + LTO)
+# Pass extra CMake options through, e.g. ./build.sh -DEHR_PGO=GENERATE
+echo "🔨 Building EHR core, console, GUI and benchmark..."
+cmake -S . -B build -DCMAKE_BUILD_TYPE=Release "$@" && cmake --build build -j"$(nproc)"
 
 # 4. Run the application ONLY if compilation succeeded
 # $? checks the exit code of the previous command (0 means success)
+# The GUI target is skipped when CMake cannot find FLTK; fall back to the console.
 if [ $? -eq 0 ]; then
-    echo "🚀 Compilation successful! Starting EHR GUI..."
-    echo "----------------------------------------"
-    ./ehr_gui
+    if [ -x ./build/ehr_gui ]; then
+        echo "🚀 Compilation successful! Starting EHR GUI..."
+        echo "----------------------------------------"
+        ./build/ehr_gui
+    else
+        echo "⚠️  Compilation successful, but ehr_gui was not built (FLTK not found by CMake)."
+        echo "🚀 Starting the console version (./build/main) instead..."
+        echo "----------------------------------------"
+        ./build/main
+    fi
 else
     echo "❌ Compilation failed. Please check your code errors above."
     exit 1
-fi
\ No newline at end of file
+fi
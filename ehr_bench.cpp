@@ -0,0 +1,97 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "ehr_core.h"
+
+using namespace std;
+
+// Core benchmark.
+// Drives the shared core through each operation with a synthetic network and
+// reports the cost per operation. Also used as the PGO training run.
+//   ./ehr_bench [patients = 100000] [history budget MB = 64]
+
+struct BenchTimer {
+    string phase;
+    size_t ops;
+    chrono::steady_clock::time_point start;
+
+    BenchTimer(string name, size_t count) : phase(move(name)), ops(count), start(chrono::steady_clock::now()) {}
+
+    ~BenchTimer() {
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        cout << left << setw(18) << phase << right << setw(10) << ops << setw(14) << ns / 1e6
+             << setw(14) << ns / ops << "\n";
+    }
+};
+
+int main(int argc, char* argv[]) {
+    size_t numPatients = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+    size_t budgetMb = argc > 2 ? strtoul(argv[2], nullptr, 10) : 64;
+    size_t numDoctors = max<size_t>(numPatients / 50, 1);
+    const size_t RECORDS_PER_PATIENT = 3;
+    const size_t READS = 10000, SEARCHES = 5, PATHS = 10;
+
+    EHRSystem ehr(budgetMb * 1024 * 1024);
+    mt19937 rng(42);
+    auto pick = [&](size_t n) { return uniform_int_distribution<size_t>(0, n - 1)(rng); };
+    auto docId = [](size_t i) { return "D" + to_string(i); };
+    auto patId = [](size_t i) { return "P" + to_string(i); };
+
+    static const char* symptoms[] = {"Chest Pain", "Rash", "Headache", "Fever", "Cough", "Back Pain"};
+    static const char* diagnoses[] = {"Angina", "Eczema", "Migraine", "Influenza", "Bronchitis", "Sciatica"};
+
+    cout << "EHR core benchmark: " << numPatients << " patients, " << numDoctors << " doctors, "
+         << budgetMb << " MB history budget\n";
+    cout << left << setw(18) << "Phase" << right << setw(10) << "Ops" << setw(14) << "Total (ms)"
+         << setw(14) << "ns/op" << "\n";
+    cout << fixed << setprecision(1);
+
+    {
+        BenchTimer t("addDoctor", numDoctors);
+        for (size_t i = 0; i < numDoctors; ++i) ehr.addDoctor(docId(i), "Doctor " + to_string(i), "General");
+    }
+    {
+        BenchTimer t("addPatient", numPatients);
+        for (size_t i = 0; i < numPatients; ++i) ehr.addPatient(patId(i), "Patient " + to_string(i));
+    }
+    {
+        BenchTimer t("linkDoctorPatient", numPatients * 2);
+        for (size_t i = 0; i < numPatients; ++i) {
+            ehr.linkDoctorPatient(docId(pick(numDoctors)), patId(i));
+            ehr.linkDoctorPatient(docId(pick(numDoctors)), patId(i));
+        }
+    }
+    {
+        BenchTimer t("addMedicalRecord", numPatients * RECORDS_PER_PATIENT);
+        for (size_t r = 0; r < RECORDS_PER_PATIENT; ++r) {
+            for (size_t i = 0; i < numPatients; ++i) {
+                size_t k = pick(6);
+                ehr.addMedicalRecord(patId(i), docId(pick(numDoctors)), "2025-10-" + to_string(10 + r),
+                                     symptoms[k], diagnoses[k], "Standard treatment");
+            }
+        }
+    }
+    {
+        BenchTimer t("getPatientHistory", READS);
+        for (size_t i = 0; i < READS; ++i) ehr.getPatientHistory(patId(pick(numPatients)));
+    }
+    {
+        EHRSystem::Snapshot snap = ehr.openSnapshot();
+        BenchTimer t("snapshot read", READS);
+        for (size_t i = 0; i < READS; ++i) ehr.getPatientSnapshot(patId(pick(numPatients)), snap);
+    }
+    {
+        BenchTimer t("keyword search", SEARCHES);
+        for (size_t i = 0; i < SEARCHES; ++i) ehr.findPatientsByKeyword(diagnoses[i % 6]);
+    }
+    {
+        BenchTimer t("shortest path", PATHS);
+        for (size_t i = 0; i < PATHS; ++i) ehr.findShortestPath(docId(pick(numDoctors)), patId(pick(numPatients)));
+    }
+    cout << "History segment: " << ehr.historySegmentBytes() / 1024 << " KB\n";
+    return 0;
+}
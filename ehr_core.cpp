@@ -0,0 +1,554 @@
+#include "ehr_core.h"
+
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <set>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace std;
+
+// ======================================================================
+// LIFECYCLE
+// ======================================================================
+
+EHRSystem::EHRSystem(size_t historyBudgetBytes, const string& segmentDir)
+    : segmentDir(segmentDir), segmentSize(0), deadBytes(0), memoryBudget(historyBudgetBytes), residentBytes(0), clockHand(0),
+      currentVersion(0) {}
+
+EHRSystem::~EHRSystem() {
+    for (auto& pair : patients) delete pair.second;
+    for (auto& pair : doctors) delete pair.second;
+}
+
+bool EHRSystem::smartSearch(const string& text, const string& lowerQuery) {
+    string lowerText = text;
+    transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+    return lowerText.find(lowerQuery) != string::npos;
+}
+
+// ======================================================================
+// MUTATIONS
+// ======================================================================
+
+string EHRSystem::addDoctor(const string& id, const string& name, const string& spec) {
+    if (doctors.count(id)) return "Error: Doctor ID " + id + " already exists.";
+    Doctor* d = new Doctor(id, name, spec);
+    doctors[id] = d;
+    // An ID may be both a doctor and a patient; keep links made in either role.
+    adjList.emplace(id, vector<string>());
+    linkVersions.emplace(id, vector<uint64_t>());
+    d->version = commitVersion();
+    cdc.publish(CDC_ADD_DOCTOR, d->version, {&id, &name, &spec});
+    return "Success: Doctor " + name + " registered.";
+}
+
+string EHRSystem::addPatient(const string& id, const string& name) {
+    if (patients.count(id)) return "Error: Patient ID " + id + " already exists.";
+    Patient* p = new Patient(id, name);
+    patients[id] = p;
+    adjList.emplace(id, vector<string>());
+    linkVersions.emplace(id, vector<uint64_t>());
+    p->version = commitVersion();
+    cdc.publish(CDC_ADD_PATIENT, p->version, {&id, &name});
+    return "Success: Patient " + name + " registered.";
+}
+
+string EHRSystem::linkDoctorPatient(const string& docId, const string& patId) {
+    if (!doctors.count(docId) || !patients.count(patId)) return "Error: Invalid IDs.";
+    uint64_t v = commitVersion();
+    adjList[docId].push_back(patId);
+    linkVersions[docId].push_back(v);
+    if (patId != docId) {
+        adjList[patId].push_back(docId);
+        linkVersions[patId].push_back(v);
+    }
+    cdc.publish(CDC_LINK, v, {&docId, &patId});
+    return "Network: Linked " + docId + " with " + patId;
+}
+
+string EHRSystem::addMedicalRecord(const string& patId, const string& docId, const string& date,
+                                   const string& sym, const string& dx, const string& px) {
+    auto it = patients.find(patId);
+    if (it == patients.end()) return "Error: Patient not found.";
+    Patient* patient = it->second;
+    MedicalRecord* newRec = new MedicalRecord(date, sym, dx, px, docId);
+    newRec->version = currentVersion + 1; // handed out by commitVersion() below
+    if (patient->spilled) {
+        // A cold history grows on disk by one small extent; nothing is paged in.
+        bool written = appendExtent(patient, newRec);
+        delete newRec;
+        if (!written) return "Error: Could not write the record of " + patient->name + " to the segment file.";
+    } else {
+        appendRecord(patient, newRec);
+        patient->referenced = true;
+        enforceMemoryBudget(patient);
+    }
+    commitVersion();
+    cdc.publish(CDC_ADD_RECORD, currentVersion, {&patId, &docId, &date, &sym, &dx, &px});
+    return "Clinical Note: Record added for " + patient->name;
+}
+
+// ======================================================================
+// REPORTS
+// ======================================================================
+
+static void formatRecord(ostringstream& oss, const MedicalRecord* rec, int number) {
+    oss << "RECORD #" << number << "  [Date: " << rec->date << "]\n";
+    oss << "  Attending Physician ID : " << rec->doctorId << "\n";
+    oss << "  Presented Symptoms     : " << rec->symptoms << "\n";
+    oss << "  Clinical Diagnosis     : " << rec->diagnosis << "\n";
+    oss << "  Prescribed Treatment   : " << rec->prescription << "\n";
+    oss << "--------------------------------------------------------\n";
+}
+
+string EHRSystem::getPatientHistory(const string& patId) {
+    ostringstream oss;
+    auto it = patients.find(patId);
+    if (it == patients.end()) return "Error: Patient not found.";
+    Patient* p = it->second;
+    if (!touchHistory(p)) return historyReadError(p);
+    if (!p->historyHead) return "System: No medical records found.";
+
+    oss << "CLINICAL HISTORY REPORT: " << p->name << " (ID: " << p->id << ")\n";
+    oss << "========================================================\n";
+    MedicalRecord* cur = p->historyHead;
+    int count = 1;
+    while (cur) {
+        formatRecord(oss, cur, count++);
+        cur = cur->next;
+    }
+    return oss.str();
+}
+
+// Point-in-time audit: history and care network as of a snapshot.
+string EHRSystem::getPatientSnapshot(const string& patId, const Snapshot& snap) {
+    ostringstream oss;
+    auto it = patients.find(patId);
+    if (it == patients.end()) return "Error: Patient not found.";
+    if (!snap.valid) return "Error: " + snap.error;
+    Patient* p = it->second;
+    if (p->version > snap.version)
+        return "Error: Patient " + p->id + " was not registered yet at v" + to_string(snap.version) + ".";
+    if (!touchHistory(p)) return historyReadError(p);
+
+    oss << "POINT-IN-TIME REPORT: " << p->name << " (ID: " << p->id << ") @ v" << snap.version << "\n";
+    oss << "========================================================\n";
+    int count = 1;
+    for (MedicalRecord* cur = p->historyHead; cur && cur->version <= snap.version; cur = cur->next)
+        formatRecord(oss, cur, count++);
+    if (count == 1) oss << "No medical records at this point in time.\n";
+
+    oss << "\nCARE NETWORK:\n";
+    const vector<string>& links = adjList.at(patId);
+    const vector<uint64_t>& stamps = linkVersions.at(patId);
+    // The adjacency is keyed by ID, so an ID that is also a doctor lists its
+    // own patients here too; only neighbours that are doctors are care links.
+    for (size_t i = 0; i < links.size() && stamps[i] <= snap.version; ++i) {
+        auto doc = doctors.find(links[i]);
+        if (doc != doctors.end()) oss << "  |--> [DR] " << doc->second->name << " (" << links[i] << ")\n";
+    }
+    return oss.str();
+}
+
+string EHRSystem::findPatientsByKeyword(const string& keyword) {
+    ostringstream oss;
+    if (keyword.empty()) return "Error: Please enter a search term.";
+    string lowerQuery = keyword;
+    transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+
+    oss << "SEARCH RESULTS FOR: '" << keyword << "'\n";
+    oss << "==========================================\n";
+    bool found = false;
+    for (auto& pair : patients) {
+        Patient* p = pair.second;
+        if (!touchHistory(p)) {
+            oss << "[ERROR] Patient: " << p->name << " (ID: " << p->id << ") - history unreadable, not searched\n";
+            found = true;
+            continue;
+        }
+        MedicalRecord* cur = p->historyHead;
+        while (cur) {
+            if (smartSearch(cur->symptoms, lowerQuery) || smartSearch(cur->diagnosis, lowerQuery)) {
+                oss << "[MATCH] Patient: " << p->name << " (ID: " << p->id << ")\n";
+                oss << "        Date: " << cur->date << " | Dx: " << cur->diagnosis << "\n";
+                found = true;
+                break;
+            }
+            cur = cur->next;
+        }
+    }
+    return found ? oss.str() : "System: No records found.";
+}
+
+string EHRSystem::getAllDataInTable() const {
+    ostringstream oss;
+    oss << left;
+    oss << "=== REGISTERED PHYSICIANS ===\n";
+    oss << setw(12) << "ID" << setw(25) << "Name" << "Specialization\n";
+    oss << "------------------------------------------------------------\n";
+    for (const auto& pair : doctors) oss << setw(12) << pair.second->id << setw(25) << pair.second->name << pair.second->specialization << "\n";
+
+    oss << "\n=== REGISTERED PATIENTS ===\n";
+    oss << setw(12) << "ID" << "Name\n";
+    oss << "------------------------------------------------------------\n";
+    for (const auto& pair : patients) oss << setw(12) << pair.second->id << pair.second->name << "\n";
+    return oss.str();
+}
+
+string EHRSystem::getLinkTree() const {
+    ostringstream oss;
+    oss << "--- NETWORK LINKAGE TREE ---\n";
+    for (const auto& pair : doctors) {
+        if (!adjList.at(pair.first).empty()) {
+            oss << "\n[DR] " << pair.second->name << "\n";
+            for (const auto& pid : adjList.at(pair.first)) {
+                auto pat = patients.find(pid);
+                if (pat != patients.end()) oss << "  |--> [PAT] " << pat->second->name << "\n";
+            }
+        }
+    }
+    return oss.str();
+}
+
+// --- DIJKSTRA'S ALGORITHM IMPLEMENTATION (Harsimran) ---
+
+string EHRSystem::findShortestPath(const string& startId, const string& endId) const {
+    if (adjList.find(startId) == adjList.end() || adjList.find(endId) == adjList.end()) {
+        return "Error: Start or End ID does not exist in the network.";
+    }
+
+    // Priority Queue for Dijkstra: {distance, nodeId}
+    // Using set to act as Min-Priority Queue for simplicity in C++
+    set<pair<int, string>> pq;
+    unordered_map<string, int> dist;
+    unordered_map<string, string> parent;
+
+    // Initialize distances
+    for (auto const& [key, val] : adjList) dist[key] = numeric_limits<int>::max();
+
+    dist[startId] = 0;
+    pq.insert({0, startId});
+
+    while (!pq.empty()) {
+        string u = pq.begin()->second;
+        pq.erase(pq.begin());
+
+        if (u == endId) break; // Found target
+
+        for (const string& v : adjList.at(u)) {
+            if (dist[u] + 1 < dist[v]) {
+                pq.erase({dist[v], v});
+                dist[v] = dist[u] + 1;
+                parent[v] = u;
+                pq.insert({dist[v], v});
+            }
+        }
+    }
+
+    if (dist[endId] == numeric_limits<int>::max())
+        return "No connection found between " + startId + " and " + endId;
+
+    // Reconstruct Path
+    vector<string> path;
+    string curr = endId;
+    while (curr != startId) {
+        path.push_back(curr);
+        curr = parent[curr];
+    }
+    path.push_back(startId);
+    reverse(path.begin(), path.end());
+
+    // Format Output
+    ostringstream oss;
+    oss << "SHORTEST REFERRAL CHAIN (" << dist[endId] << " hops):\n";
+    oss << "------------------------------------------\n";
+    for (size_t i = 0; i < path.size(); ++i) {
+        const string& id = path[i];
+        auto doc = doctors.find(id);
+        bool isDoctor = doc != doctors.end();
+        const string& name = isDoctor ? doc->second->name : patients.at(id)->name;
+
+        if (i > 0) oss << "   |\n   v\n";
+        oss << (isDoctor ? "[Doctor]" : "[Patient]") << " " << name << " (" << id << ")\n";
+    }
+    return oss.str();
+}
+
+// ======================================================================
+// HOT/COLD HISTORY TIERING
+// ======================================================================
+
+static size_t recordBytes(const MedicalRecord* r) {
+    return sizeof(MedicalRecord) + r->date.size() + r->symptoms.size() + r->diagnosis.size()
+         + r->prescription.size() + r->doctorId.size();
+}
+
+static void writeField(ostream& out, const string& s) {
+    uint32_t len = s.size();
+    out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    out.write(s.data(), len);
+}
+
+// Decoders for a history read back into memory; each checks the bytes left.
+static bool takeBytes(const char*& pos, const char* end, void* out, size_t n) {
+    if (static_cast<size_t>(end - pos) < n) return false;
+    memcpy(out, pos, n);
+    pos += n;
+    return true;
+}
+
+static bool takeField(const char*& pos, const char* end, string& s) {
+    uint32_t len;
+    if (!takeBytes(pos, end, &len, sizeof(len)) || static_cast<size_t>(end - pos) < len) return false;
+    s.assign(pos, len);
+    pos += len;
+    return true;
+}
+
+string EHRSystem::historyReadError(const Patient* p) {
+    return "Error: History of " + p->name + " (ID: " + p->id + ") could not be read from the segment file.";
+}
+
+// Creates a uniquely named segment file and unlinks it straight away: the open
+// stream keeps it alive, and it disappears with the process, even on a crash.
+bool EHRSystem::openSegmentFile(fstream& file) const {
+    error_code ec;
+    filesystem::path dir = segmentDir.empty() ? filesystem::temp_directory_path(ec) : filesystem::path(segmentDir);
+    if (ec) return false;
+    string path = (dir / "ehr_history_XXXXXX").string();
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) return false;
+    file.open(path, ios::in | ios::out | ios::binary);
+    unlink(path.c_str());
+    close(fd);
+    return file.is_open();
+}
+
+void EHRSystem::setHistoryMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+    enforceMemoryBudget(nullptr);
+}
+
+void EHRSystem::appendRecord(Patient* p, MedicalRecord* newRec) {
+    if (!p->historyHead) {
+        p->historyHead = newRec;
+        p->historyTail = newRec;
+    } else {
+        p->historyTail->next = newRec;
+        newRec->prev = p->historyTail;
+        p->historyTail = newRec;
+    }
+    if (p->historyBytes == 0) {
+        p->clockSlot = clockRing.size();
+        clockRing.push_back(p);
+    }
+    size_t bytes = recordBytes(newRec);
+    p->historyBytes += bytes;
+    residentBytes += bytes;
+}
+
+// Writes `from` and every record after it as one extent at the logical end of
+// the segment, so a failed earlier write is simply overwritten.
+bool EHRSystem::appendExtent(Patient* p, const MedicalRecord* from) {
+    if (!segment.is_open() && !openSegmentFile(segment)) return false;
+    if (deadBytes > SEGMENT_COMPACT_MIN && deadBytes > segmentSize - deadBytes) compactSegment();
+    segment.clear();
+    segment.seekp(segmentSize);
+    uint32_t count = 0;
+    for (const MedicalRecord* cur = from; cur; cur = cur->next) count++;
+    segment.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const MedicalRecord* cur = from; cur; cur = cur->next) {
+        writeField(segment, cur->date);
+        writeField(segment, cur->symptoms);
+        writeField(segment, cur->diagnosis);
+        writeField(segment, cur->prescription);
+        writeField(segment, cur->doctorId);
+        segment.write(reinterpret_cast<const char*>(&cur->version), sizeof(cur->version));
+    }
+    if (!segment) return false;
+    size_t bytes = static_cast<size_t>(segment.tellp()) - segmentSize;
+    p->extents.emplace_back(static_cast<streamoff>(segmentSize), bytes);
+    p->diskRecords += count;
+    segmentSize += bytes;
+    return true;
+}
+
+bool EHRSystem::spillHistory(Patient* p) {
+    // Records are append-only, so only those added since the last spill are
+    // written; the rest are already on disk.
+    MedicalRecord* from = p->historyHead;
+    for (size_t i = 0; i < p->diskRecords && from; ++i) from = from->next;
+    if (from && !appendExtent(p, from)) return false;
+    residentBytes -= p->historyBytes;
+    p->historyBytes = 0;
+    p->clearHistory();
+    p->spilled = true;
+    // Leave the ring: the last entry takes this slot.
+    Patient* last = clockRing.back();
+    clockRing[p->clockSlot] = last;
+    last->clockSlot = p->clockSlot;
+    clockRing.pop_back();
+    if (clockHand >= clockRing.size()) clockHand = 0;
+    return true;
+}
+
+// Forgets the on-disk copy; its bytes become dead space.
+void EHRSystem::dropSegmentCopy(Patient* p) {
+    for (const auto& extent : p->extents) deadBytes += extent.second;
+    p->extents.clear();
+    p->diskRecords = 0;
+}
+
+// Copies every live history into a fresh segment file as a single extent and
+// swaps the file in. New extents are only applied once the whole copy
+// succeeded, so a failure leaves the old file in use.
+bool EHRSystem::compactSegment() {
+    fstream fresh;
+    if (!openSegmentFile(fresh)) return false;
+    vector<pair<Patient*, pair<streamoff, size_t>>> moved;
+    vector<char> buf;
+    size_t offset = 0;
+    for (const auto& entry : patients) {
+        Patient* p = entry.second;
+        if (p->extents.empty()) continue;
+        uint32_t count = p->diskRecords;
+        size_t bytes = sizeof(count);
+        if (!fresh.write(reinterpret_cast<const char*>(&count), sizeof(count))) return false;
+        for (const auto& extent : p->extents) {
+            if (extent.second < sizeof(count) || extent.first + extent.second > segmentSize) return false;
+            buf.resize(extent.second - sizeof(count));
+            segment.clear();
+            segment.seekg(extent.first + static_cast<streamoff>(sizeof(count)));
+            if (!segment.read(buf.data(), buf.size()) || !fresh.write(buf.data(), buf.size())) return false;
+            bytes += buf.size();
+        }
+        moved.push_back({p, {static_cast<streamoff>(offset), bytes}});
+        offset += bytes;
+    }
+    if (!fresh.flush()) return false;
+    for (auto& entry : moved) entry.first->extents.assign(1, entry.second);
+    segment = move(fresh);
+    segmentSize = offset;
+    deadBytes = 0;
+    return true;
+}
+
+// Reads and decodes every extent of the cold copy. Any short read or
+// inconsistent length fails the page-in as a whole, leaving the patient
+// spilled with its on-disk copy intact.
+bool EHRSystem::pageInHistory(Patient* p) {
+    vector<MedicalRecord*> records;
+    vector<char> buf;
+    string dt, sym, dx, px, docId;
+    uint64_t version;
+    bool ok = true;
+    for (size_t e = 0; e < p->extents.size() && ok; ++e) {
+        streamoff offset = p->extents[e].first;
+        size_t bytes = p->extents[e].second;
+        if (offset < 0 || offset + bytes > segmentSize) { ok = false; break; }
+        buf.resize(bytes);
+        segment.clear();
+        segment.seekg(offset);
+        if (!segment.read(buf.data(), buf.size())) { ok = false; break; }
+
+        const char* pos = buf.data();
+        const char* end = pos + buf.size();
+        uint32_t count;
+        ok = takeBytes(pos, end, &count, sizeof(count));
+        for (uint32_t i = 0; i < count && ok; ++i) {
+            ok = takeField(pos, end, dt) && takeField(pos, end, sym) && takeField(pos, end, dx)
+                 && takeField(pos, end, px) && takeField(pos, end, docId) && takeBytes(pos, end, &version, sizeof(version));
+            if (ok) {
+                records.push_back(new MedicalRecord(move(dt), move(sym), move(dx), move(px), move(docId)));
+                records.back()->version = version;
+            }
+        }
+        ok = ok && pos == end;
+    }
+    if (!ok || records.size() != p->diskRecords) {
+        for (MedicalRecord* rec : records) delete rec;
+        return false;
+    }
+    for (MedicalRecord* rec : records) appendRecord(p, rec);
+    p->spilled = false;
+    // A chain grown by many cold appends is rewritten as one extent on the
+    // next spill instead of being read piecewise again.
+    if (p->extents.size() > MAX_EXTENTS) dropSegmentCopy(p);
+    return true;
+}
+
+void EHRSystem::enforceMemoryBudget(Patient* pinned) {
+    // Two sweeps are enough for CLOCK to clear every reference bit once. Stop
+    // as soon as only the pinned history is left resident.
+    size_t pinnedBytes = pinned ? pinned->historyBytes : 0;
+    size_t steps = 2 * clockRing.size();
+    while (residentBytes > memoryBudget && residentBytes > pinnedBytes && steps-- > 0) {
+        Patient* p = clockRing[clockHand];
+        clockHand = (clockHand + 1) % clockRing.size();
+        if (p == pinned) continue;
+        if (p->referenced) { p->referenced = false; continue; }
+        if (!spillHistory(p)) return;
+    }
+}
+
+bool EHRSystem::touchHistory(Patient* p) {
+    if (p->spilled && !pageInHistory(p)) return false;
+    p->referenced = true;
+    enforceMemoryBudget(p);
+    return true;
+}
+
+// ======================================================================
+// MULTI-VERSION SNAPSHOTS
+// ======================================================================
+
+uint64_t EHRSystem::commitVersion() {
+    // Commits within the same second share an entry. If the clock steps
+    // back, they join the latest entry so the log stays sorted by time.
+    time_t now = time(nullptr);
+    ++currentVersion;
+    if (commitLog.empty() || now > commitLog.back().second) commitLog.emplace_back(currentVersion, now);
+    return currentVersion;
+}
+
+// Strictly parses "YYYY-MM-DD[ HH:MM:SS]" as UTC; a date alone means the
+// last second of that day. Out-of-range fields such as 2025-02-30 fail the
+// round trip through gmtime.
+static bool parseUtc(const string& when, time_t& out) {
+    static const char DATE[] = "dddd-dd-dd", DATE_TIME[] = "dddd-dd-dd dd:dd:dd";
+    const char* shape = when.size() == 10 ? DATE : when.size() == 19 ? DATE_TIME : nullptr;
+    if (!shape) return false;
+    for (size_t i = 0; i < when.size(); ++i) {
+        bool ok = shape[i] == 'd' ? isdigit(static_cast<unsigned char>(when[i])) != 0 : when[i] == shape[i];
+        if (!ok) return false;
+    }
+    auto num = [&](size_t pos, size_t len) { return stoi(when.substr(pos, len)); };
+    tm t = {};
+    t.tm_year = num(0, 4) - 1900;
+    t.tm_mon = num(5, 2) - 1;
+    t.tm_mday = num(8, 2);
+    t.tm_hour = when.size() == 19 ? num(11, 2) : 23;
+    t.tm_min = when.size() == 19 ? num(14, 2) : 59;
+    t.tm_sec = when.size() == 19 ? num(17, 2) : 59;
+    tm want = t;
+    out = timegm(&t);
+    tm back;
+    return gmtime_r(&out, &back) && back.tm_year == want.tm_year && back.tm_mon == want.tm_mon
+           && back.tm_mday == want.tm_mday && back.tm_hour == want.tm_hour && back.tm_min == want.tm_min
+           && back.tm_sec == want.tm_sec;
+}
+
+EHRSystem::Snapshot EHRSystem::openSnapshotAt(const string& when) const {
+    time_t at;
+    if (!parseUtc(when, at))
+        return {0, false, "Invalid date '" + when + "'. Use YYYY-MM-DD or YYYY-MM-DD HH:MM:SS (UTC)."};
+    auto it = upper_bound(commitLog.begin(), commitLog.end(), at,
+                          [](time_t t, const pair<uint64_t, time_t>& c) { return t < c.second; });
+    // Before the first commit the system was empty: version 0.
+    if (it == commitLog.begin()) return {0, true, ""};
+    return {it == commitLog.end() ? currentVersion : it->first - 1, true, ""};
+}
@@ -0,0 +1,518 @@
+#ifndef EHR_CORE_H
+#define EHR_CORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <deque>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+/*
+ * EHR CORE LIBRARY
+ * ---------------------------------------------------------
+ * Shared by the console (main.cpp) and GUI (ehr_gui.cpp) front ends and by
+ * the benchmark (ehr_bench.cpp). The core never prints: mutations return a
+ * status line and queries return a formatted report for the front end to show.
+ * ---------------------------------------------------------
+ */
+
+// ======================================================================
+// MODULE 1: PATIENT DATA STRUCTURES (Kapish)
+// ======================================================================
+
+struct MedicalRecord {
+    std::string date, symptoms, diagnosis, prescription, doctorId;
+    uint64_t version;
+    MedicalRecord *next;
+    MedicalRecord *prev;
+    MedicalRecord(std::string dt, std::string sym, std::string dx, std::string px, std::string docId)
+        : date(std::move(dt)), symptoms(std::move(sym)), diagnosis(std::move(dx)), prescription(std::move(px)), doctorId(std::move(docId)),
+          version(0), next(nullptr), prev(nullptr) {}
+};
+
+struct Patient {
+    std::string id, name;
+    MedicalRecord *historyHead;
+    MedicalRecord *historyTail;
+    // Tiering state: the first diskRecords records of the history are in the
+    // segment file as a chain of (offset, bytes) extents. While spilled, the
+    // list above is empty and the disk copy is the whole history.
+    bool spilled;
+    bool referenced;
+    size_t clockSlot; // index in the CLOCK ring while the history is resident
+    std::vector<std::pair<std::streamoff, size_t>> extents;
+    size_t diskRecords;
+    size_t historyBytes;
+    uint64_t version; // commit version that registered the patient
+    Patient(std::string patientId, std::string patientName)
+        : id(std::move(patientId)), name(std::move(patientName)), historyHead(nullptr), historyTail(nullptr),
+          spilled(false), referenced(true), clockSlot(0), diskRecords(0), historyBytes(0), version(0) {}
+    void clearHistory() {
+        MedicalRecord *current = historyHead;
+        while (current != nullptr) {
+            MedicalRecord *toDelete = current;
+            current = current->next;
+            delete toDelete;
+        }
+        historyHead = historyTail = nullptr;
+    }
+    ~Patient() { clearHistory(); }
+};
+
+// ======================================================================
+// MODULE 2: PROVIDER STRUCTURES (Medhansh)
+// ======================================================================
+
+struct Doctor {
+    std::string id, name, specialization;
+    uint64_t version; // commit version that registered the doctor
+    Doctor(std::string docId, std::string docName, std::string spec)
+        : id(std::move(docId)), name(std::move(docName)), specialization(std::move(spec)), version(0) {}
+};
+
+// ======================================================================
+// MODULE 3: CHANGE-DATA-CAPTURE FEED
+// ======================================================================
+
+enum CdcEventType : uint8_t { CDC_ADD_DOCTOR = 1, CDC_ADD_PATIENT, CDC_LINK, CDC_ADD_RECORD };
+
+// A decoded change event. Fields are packed NUL-separated into payload.
+struct CdcEvent {
+    uint64_t version;
+    uint8_t type;
+    std::string payload;
+
+    std::vector<std::string> fields() const {
+        std::vector<std::string> out;
+        size_t start = 0;
+        for (size_t i = 0; i < payload.size(); ++i) {
+            if (payload[i] == '\0') { out.emplace_back(payload, start, i - start); start = i + 1; }
+        }
+        return out;
+    }
+};
+
+// Fixed header in front of every event, both in the ring and in the replay log.
+struct CdcHeader {
+    uint64_t version;
+    uint32_t length;
+    uint8_t type;
+    uint8_t flags; // CDC_MORE / CDC_CONTINUED, ring only
+    uint8_t reserved[2];
+};
+
+// Single-producer, multi-consumer broadcast ring. The EHR core is the only
+// writer; every subscriber reads with its own cursor. An event takes as many
+// consecutive 256-byte slots as its header and payload need; one larger than
+// a quarter of the ring is split into chunks that poll() joins back, so any
+// event can be published. When the ring is full the producer waits for the
+// slowest active subscriber (backpressure), but only up to
+// backpressureTimeout: a subscriber still in the way after that is dropped
+// and sees overrun() == true. With nobody subscribed nothing is written. Kept
+// in the header so publish() inlines into the write path.
+class CdcFeed {
+private:
+    static const int MAX_CONSUMERS = 8;
+    static const size_t SLOT_BYTES = 256;
+    static const uint32_t MAX_LOG_EVENT = 64 * 1024 * 1024;
+    static const uint8_t CDC_MORE = 1;      // the payload goes on in the next chunk
+    static const uint8_t CDC_CONTINUED = 2; // this chunk goes on from the previous one
+
+    struct Slot { char bytes[SLOT_BYTES]; };
+
+    std::vector<Slot> ring;
+    uint64_t mask;
+    std::atomic<uint64_t> head;
+    uint64_t gateCache;
+    std::atomic<uint64_t> cursors[MAX_CONSUMERS];
+    std::atomic<bool> active[MAX_CONSUMERS];
+    std::atomic<bool> overrunFlags[MAX_CONSUMERS];
+    // Consumer-side state of an event being joined from chunks.
+    std::string partial[MAX_CONSUMERS];
+    bool joining[MAX_CONSUMERS];
+    std::chrono::microseconds backpressureTimeout;
+
+    std::thread sinkThread;
+    std::atomic<bool> sinkRunning;
+    int sinkConsumer;
+
+    static size_t slotsFor(size_t payloadBytes) {
+        return (sizeof(CdcHeader) + payloadBytes + SLOT_BYTES - 1) / SLOT_BYTES;
+    }
+
+    uint64_t slowestCursor(uint64_t seq) const {
+        uint64_t slowest = seq;
+        for (int i = 0; i < MAX_CONSUMERS; ++i)
+            if (active[i].load(std::memory_order_acquire)) slowest = std::min(slowest, cursors[i].load(std::memory_order_acquire));
+        return slowest;
+    }
+
+    size_t maxChunk() const { return std::max<size_t>(ring.size() / 4, 1) * SLOT_BYTES - sizeof(CdcHeader); }
+
+    bool anySubscriber() const {
+        for (int i = 0; i < MAX_CONSUMERS; ++i)
+            if (active[i].load(std::memory_order_acquire)) return true;
+        return false;
+    }
+
+    bool ringFull(uint64_t seq, size_t slots) const { return seq + slots - gateCache > ring.size(); }
+
+    // Waits for the slowest subscriber to free `slots` slots; false once `timeout` expires.
+    bool waitForSpace(uint64_t seq, size_t slots, std::chrono::microseconds timeout) {
+        gateCache = slowestCursor(seq);
+        if (!ringFull(seq, slots)) return true;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        unsigned idle = 0;
+        while (std::chrono::steady_clock::now() < deadline) {
+            backoff(idle);
+            gateCache = slowestCursor(seq);
+            if (!ringFull(seq, slots)) return true;
+        }
+        return false;
+    }
+
+    // Detaches every subscriber whose unread slots would be overwritten.
+    void dropLaggards(uint64_t seq, size_t slots) {
+        for (int i = 0; i < MAX_CONSUMERS; ++i) {
+            if (active[i].load(std::memory_order_acquire)
+                && seq + slots - cursors[i].load(std::memory_order_acquire) > ring.size()) {
+                overrunFlags[i].store(true);
+                active[i].store(false);
+            }
+        }
+        // Pairs with the acquire fence in poll(): no byte of the overwrite
+        // below may become visible before the flags above. Even a seq_cst
+        // store lets later plain stores move ahead of it on weak CPUs.
+        std::atomic_thread_fence(std::memory_order_release);
+        gateCache = slowestCursor(seq);
+    }
+
+    // Copies `n` bytes to/from the event starting at slot `seq`, `offset` bytes in,
+    // wrapping around the ring as needed.
+    void copyIn(uint64_t seq, size_t offset, const char* src, size_t n) {
+        while (n > 0) {
+            size_t chunk = std::min(n, SLOT_BYTES - offset % SLOT_BYTES);
+            std::memcpy(ring[(seq + offset / SLOT_BYTES) & mask].bytes + offset % SLOT_BYTES, src, chunk);
+            src += chunk; offset += chunk; n -= chunk;
+        }
+    }
+
+    void copyOut(uint64_t seq, size_t offset, char* dst, size_t n) const {
+        while (n > 0) {
+            size_t chunk = std::min(n, SLOT_BYTES - offset % SLOT_BYTES);
+            std::memcpy(dst, ring[(seq + offset / SLOT_BYTES) & mask].bytes + offset % SLOT_BYTES, chunk);
+            dst += chunk; offset += chunk; n -= chunk;
+        }
+    }
+
+    // Writes bytes [from, from + length) of the packed payload as one chunk.
+    void writeChunk(uint64_t seq, size_t slots, CdcEventType type, uint64_t version, uint8_t flags,
+                    std::initializer_list<const std::string*> fields, size_t from, size_t length) {
+        CdcHeader h = {version, static_cast<uint32_t>(length), type, flags, {0, 0}};
+        copyIn(seq, 0, reinterpret_cast<const char*>(&h), sizeof(h));
+        size_t offset = sizeof(h), pos = 0;
+        for (const std::string* f : fields) {
+            size_t fieldEnd = pos + f->size() + 1;
+            if (fieldEnd > from && pos < from + length) {
+                size_t begin = std::max(from, pos), end = std::min(from + length, fieldEnd);
+                copyIn(seq, offset, f->c_str() + (begin - pos), end - begin);
+                offset += end - begin;
+            }
+            pos = fieldEnd;
+        }
+        head.store(seq + slots, std::memory_order_release);
+    }
+
+    // Publishes an event as one or more chunks. Blocking waits per chunk and
+    // then drops laggards; otherwise the whole event must fit in the free
+    // slots right now, or nothing is written.
+    bool writeEvent(CdcEventType type, uint64_t version, std::initializer_list<const std::string*> fields,
+                    bool blocking) {
+        if (!anySubscriber()) return true;
+        size_t length = payloadSize(fields);
+        size_t chunk = maxChunk();
+        if (!blocking) {
+            size_t total = 0, from = 0;
+            do {
+                size_t n = std::min(chunk, length - from);
+                total += slotsFor(n);
+                from += n;
+            } while (from < length);
+            uint64_t seq = head.load(std::memory_order_relaxed);
+            if (total > ring.size()) return false;
+            if (ringFull(seq, total) && !waitForSpace(seq, total, std::chrono::microseconds(0))) return false;
+        }
+        size_t from = 0;
+        do {
+            size_t n = std::min(chunk, length - from);
+            size_t slots = slotsFor(n);
+            uint64_t seq = head.load(std::memory_order_relaxed);
+            if (ringFull(seq, slots) && !waitForSpace(seq, slots, backpressureTimeout)) dropLaggards(seq, slots);
+            uint8_t flags = (from > 0 ? CDC_CONTINUED : 0) | (from + n < length ? CDC_MORE : 0);
+            writeChunk(seq, slots, type, version, flags, fields, from, n);
+            from += n;
+        } while (from < length);
+        return true;
+    }
+
+    static void appendToLog(FILE* out, const CdcEvent& e) {
+        CdcHeader h = {e.version, static_cast<uint32_t>(e.payload.size()), e.type, 0, {0, 0}};
+        fwrite(&h, sizeof(h), 1, out);
+        fwrite(e.payload.data(), 1, e.payload.size(), out);
+    }
+
+public:
+    // capacity (in slots) must be a power of two; it also bounds the largest event.
+    CdcFeed(size_t capacity = 4096)
+        : ring(capacity), mask(capacity - 1), head(0), gateCache(0), backpressureTimeout(100000),
+          sinkRunning(false), sinkConsumer(-1) {
+        for (int i = 0; i < MAX_CONSUMERS; ++i) {
+            cursors[i] = 0; active[i] = false; overrunFlags[i] = false; joining[i] = false;
+        }
+    }
+
+    ~CdcFeed() { stopFileSink(); }
+
+    // Spins briefly, then sleeps with exponential backoff (up to 10 ms), so an
+    // idle waiter costs no CPU.
+    static void backoff(unsigned& idle) {
+        if (idle < 16) std::this_thread::yield();
+        else std::this_thread::sleep_for(std::chrono::microseconds(std::min(50u << std::min(idle - 16, 8u), 10000u)));
+        idle++;
+    }
+
+    static size_t payloadSize(std::initializer_list<const std::string*> fields) {
+        size_t len = 0;
+        for (const std::string* f : fields) len += f->size() + 1;
+        return len;
+    }
+
+    void setBackpressureTimeout(std::chrono::microseconds timeout) { backpressureTimeout = timeout; }
+
+    // Waits at most backpressureTimeout per chunk, then drops the laggards.
+    void publish(CdcEventType type, uint64_t version, std::initializer_list<const std::string*> fields) {
+        writeEvent(type, version, fields, true);
+    }
+
+    // Never blocks: returns false, publishing nothing, if subscribers hold the
+    // slots the event needs (or it is larger than the whole ring).
+    bool tryPublish(CdcEventType type, uint64_t version, std::initializer_list<const std::string*> fields) {
+        return writeEvent(type, version, fields, false);
+    }
+
+    // Returns a consumer id, or -1 if every cursor is taken.
+    int subscribe() {
+        for (int i = 0; i < MAX_CONSUMERS; ++i) {
+            bool expected = false;
+            if (!active[i].load() && active[i].compare_exchange_strong(expected, true)) {
+                overrunFlags[i].store(false);
+                partial[i].clear();
+                joining[i] = false;
+                cursors[i].store(head.load(std::memory_order_acquire), std::memory_order_release);
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void unsubscribe(int consumer) { active[consumer].store(false, std::memory_order_release); }
+
+    // True once the producer dropped this subscriber for holding up the ring.
+    bool overrun(int consumer) const { return overrunFlags[consumer].load(); }
+
+    // Returns whole events only; chunks of a split event are joined here.
+    bool poll(int consumer, CdcEvent& out) {
+        std::string& buf = partial[consumer];
+        for (;;) {
+            if (!active[consumer].load(std::memory_order_acquire)) return false;
+            uint64_t cur = cursors[consumer].load(std::memory_order_relaxed);
+            if (cur == head.load(std::memory_order_acquire)) return false;
+            CdcHeader h;
+            copyOut(cur, 0, reinterpret_cast<char*>(&h), sizeof(h));
+            if (slotsFor(h.length) > ring.size()) return false; // torn by an overwrite, see below
+            size_t base = buf.size();
+            buf.resize(base + h.length);
+            copyOut(cur, sizeof(h), &buf[base], h.length);
+            // Seqlock-style validation: the producer flags a dropped subscriber and
+            // issues a release fence before reusing its slots, so a copy that raced
+            // with an overwrite is discarded here. That copy does read the ring
+            // bytes without synchronisation; its contents are never used, and
+            // the length check above keeps a torn header from sizing the copy.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (overrunFlags[consumer].load()) { buf.clear(); return false; }
+            cursors[consumer].store(cur + slotsFor(h.length), std::memory_order_release);
+            // A chunk continuing an event this consumer subscribed in the middle of is skipped.
+            if ((h.flags & CDC_CONTINUED) && !joining[consumer]) { buf.clear(); continue; }
+            joining[consumer] = (h.flags & CDC_MORE) != 0;
+            if (joining[consumer]) continue;
+            out.version = h.version;
+            out.type = h.type;
+            out.payload.swap(buf);
+            buf.clear();
+            return true;
+        }
+    }
+
+    // Optional replay log: a background consumer appends every event to `path`.
+    bool startFileSink(const std::string& path) {
+        if (sinkRunning) return false;
+        FILE* out = fopen(path.c_str(), "ab");
+        if (!out) return false;
+        sinkConsumer = subscribe();
+        if (sinkConsumer < 0) { fclose(out); return false; }
+        sinkRunning = true;
+        sinkThread = std::thread([this, out]() {
+            CdcEvent e;
+            unsigned idle = 0;
+            while (sinkRunning.load(std::memory_order_acquire)) {
+                if (poll(sinkConsumer, e)) { appendToLog(out, e); idle = 0; }
+                else if (overrun(sinkConsumer)) break;
+                else backoff(idle);
+            }
+            while (poll(sinkConsumer, e)) appendToLog(out, e);
+            if (overrun(sinkConsumer)) fprintf(stderr, "CDC: file sink fell behind; replay log is incomplete.\n");
+            fflush(out);
+            fclose(out);
+        });
+        return true;
+    }
+
+    void stopFileSink() {
+        if (!sinkRunning) return;
+        sinkRunning = false;
+        sinkThread.join();
+        unsubscribe(sinkConsumer);
+        sinkConsumer = -1;
+    }
+
+    static size_t replay(const std::string& path, const std::function<void(const CdcEvent&)>& apply) {
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return 0;
+        size_t count = 0;
+        CdcHeader h;
+        CdcEvent e;
+        while (fread(&h, sizeof(h), 1, in) == 1) {
+            e.version = h.version;
+            e.type = h.type;
+            if (h.length > MAX_LOG_EVENT) break; // corrupt log
+            e.payload.resize(h.length);
+            if (h.length && fread(&e.payload[0], 1, h.length, in) != h.length) break;
+            apply(e);
+            count++;
+        }
+        fclose(in);
+        return count;
+    }
+};
+
+// ======================================================================
+// MODULE 4: CORE SYSTEM ARCHITECTURE (Harsimran & Aryan)
+// ======================================================================
+
+class EHRSystem {
+public:
+    struct Snapshot {
+        uint64_t version;
+        bool valid;
+        std::string error; // why the snapshot could not be opened
+    };
+
+    // Cold histories go to a private, already-unlinked file in segmentDir
+    // (empty = the system temp directory), so instances never share one.
+    EHRSystem(size_t historyBudgetBytes = 64 * 1024 * 1024, const std::string& segmentDir = "");
+    ~EHRSystem();
+
+    // Mutations return a one-line status message ("Success: ...", "Error: ...").
+    std::string addDoctor(const std::string& id, const std::string& name, const std::string& spec);
+    std::string addPatient(const std::string& id, const std::string& name);
+    std::string linkDoctorPatient(const std::string& docId, const std::string& patId);
+    std::string addMedicalRecord(const std::string& patId, const std::string& docId, const std::string& date,
+                                 const std::string& sym, const std::string& dx, const std::string& px);
+
+    // Queries return a formatted report.
+    std::string getPatientHistory(const std::string& patId);
+    std::string getPatientSnapshot(const std::string& patId, const Snapshot& snap);
+    std::string findPatientsByKeyword(const std::string& keyword);
+    std::string getAllDataInTable() const;
+    std::string getLinkTree() const;
+    std::string findShortestPath(const std::string& startId, const std::string& endId) const;
+
+    // O(1): a snapshot of the current state.
+    Snapshot openSnapshot() const { return {currentVersion, true, ""}; }
+    // Accepts "YYYY-MM-DD" (end of that day) or "YYYY-MM-DD HH:MM:SS", in UTC.
+    // Anything else is not valid.
+    Snapshot openSnapshotAt(const std::string& when) const;
+
+    void setHistoryMemoryBudget(size_t bytes);
+    // Bytes currently used by the segment file, dead copies included.
+    size_t historySegmentBytes() const { return segmentSize; }
+    CdcFeed& changeFeed() { return cdc; }
+
+private:
+    std::unordered_map<std::string, Patient*> patients;
+    std::unordered_map<std::string, Doctor*> doctors;
+    std::unordered_map<std::string, std::vector<std::string>> adjList;
+
+    // `lowerQuery` must already be lowercase.
+    static bool smartSearch(const std::string& text, const std::string& lowerQuery);
+
+    // --- Hot/Cold History Tiering ---
+    // Once the resident history exceeds memoryBudget, histories of patients
+    // nobody touched recently are spilled to a local segment file and paged
+    // back in on next access. Victims are chosen with CLOCK (second chance);
+    // the ring only holds patients with a non-empty resident history.
+    std::string segmentDir;
+    std::fstream segment;
+    size_t segmentSize;
+    // Bytes of superseded copies. Once they outweigh the live copies (and
+    // SEGMENT_COMPACT_MIN), the live copies are rewritten into a fresh file.
+    size_t deadBytes;
+    static const size_t SEGMENT_COMPACT_MIN = 1024 * 1024;
+    // A longer extent chain is rewritten as one extent after it is paged in.
+    static const size_t MAX_EXTENTS = 8;
+    size_t memoryBudget;
+    size_t residentBytes;
+    std::vector<Patient*> clockRing;
+    size_t clockHand;
+
+    bool openSegmentFile(std::fstream& file) const;
+    void appendRecord(Patient* p, MedicalRecord* newRec);
+    bool appendExtent(Patient* p, const MedicalRecord* from);
+    bool spillHistory(Patient* p);
+    void dropSegmentCopy(Patient* p);
+    bool compactSegment();
+    bool pageInHistory(Patient* p);
+    void enforceMemoryBudget(Patient* pinned);
+    // Every read or write of a history goes through here. False if a spilled
+    // history could not be read back; it then stays spilled and untouched.
+    bool touchHistory(Patient* p);
+    static std::string historyReadError(const Patient* p);
+
+    // --- Multi-Version Snapshots ---
+    // Records and links are append-only and stamped with the commit version
+    // that created them, so a snapshot is just a version number: readers skip
+    // anything newer and nothing is copied. commitLog holds one entry per
+    // second with commits: the first version committed in it and the UTC time.
+    // It is never pruned, since records and links are kept for good anyway.
+    uint64_t currentVersion;
+    std::deque<std::pair<uint64_t, time_t>> commitLog;
+    std::unordered_map<std::string, std::vector<uint64_t>> linkVersions;
+
+    // Every successful mutation is published here, stamped with its commit version.
+    CdcFeed cdc;
+
+    uint64_t commitVersion();
+};
+
+#endif
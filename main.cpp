@@ -1,231 +1,216 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <limits>
-#include <algorithm>
-#include <set>
-#include <sstream>
 #include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <iterator>
+#include "ehr_core.h"
 
 using namespace std;
 
-// Developer: Kapish
-struct MedicalRecord {
-    string date, symptoms, diagnosis, prescription, doctorId;
-    MedicalRecord *next;
-    MedicalRecord *prev;
+// Console front end.
+// All EHR logic lives in the shared core library (ehr_core.h); this file only
+// handles the interactive menu, batch mode and CDC replay.
 
-    MedicalRecord(string dt, string sym, string dx, string px, string docId)
-        : date(dt), symptoms(sym), diagnosis(dx), prescription(px), doctorId(docId), next(nullptr), prev(nullptr) {}
-};
-
-// Developer: Kapish
-struct Patient {
-    string id, name;
-    MedicalRecord *historyHead;
-    MedicalRecord *historyTail;
-
-    Patient(string patientId, string patientName)
-        : id(patientId), name(patientName), historyHead(nullptr), historyTail(nullptr) {}
+void clearBuffer() {
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+}
 
-    ~Patient() {
-        MedicalRecord *current = historyHead;
-        while (current != nullptr) {
-            MedicalRecord *toDelete = current;
-            current = current->next;
-            delete toDelete;
-        }
-    }
+// Batch mode.
+// One operation per line, fields separated by '|'; blank lines and '#' comments are skipped.
+//   doctor|D001|Ronith|Cardiologist        patient|P101|Kapish
+//   link|D001|P101                         record|P101|D001|2025-10-20|Chest Pain|Angina|Aspirin
+//   history|P101   search|pain   path|D001|P103   audit|P101|2025-09-22   db
+enum BatchOp { OP_DOCTOR, OP_PATIENT, OP_LINK, OP_RECORD, OP_HISTORY, OP_SEARCH, OP_PATH, OP_AUDIT, OP_DB, OP_COUNT };
+
+struct BatchCommand {
+    BatchOp op;
+    vector<string> args;
+    size_t line;
 };
 
-// Developer: Medhansh
-struct Doctor {
-    string id, name, specialization;
-
-    Doctor(string docId, string docName, string spec)
-        : id(docId), name(docName), specialization(spec) {}
+struct BatchOpInfo {
+    const char* name;
+    size_t arity;
 };
 
-class EHRSystem {
-private:
-    unordered_map<string, Patient*> patients;
-    unordered_map<string, Doctor*> doctors;
-    unordered_map<string, vector<string>> adjList;
-
-    bool smartSearch(const string& text, const string& query) {
-        string lowerText = text; string lowerQuery = query;
-        transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
-        transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
-        return lowerText.find(lowerQuery) != string::npos;
-    }
-
-public:
-    ~EHRSystem() {
-        for (auto const& [id, ptr] : patients) delete ptr;
-        for (auto const& [id, ptr] : doctors) delete ptr;
-    }
-
-    void addDoctor(const string& id, const string& name, const string& spec) {
-        if (doctors.count(id)) { cout << "Error: Doctor ID exists.\n"; return; }
-        doctors[id] = new Doctor(id, name, spec);
-        adjList[id] = {};
-        cout << "Success: Doctor registered.\n";
-    }
-
-    void addPatient(const string& id, const string& name) {
-        if (patients.count(id)) { cout << "Error: Patient ID exists.\n"; return; }
-        patients[id] = new Patient(id, name);
-        adjList[id] = {};
-        cout << "Success: Patient registered.\n";
-    }
-
-    void linkDoctorPatient(const string& docId, const string& patId) {
-        if (!doctors.count(docId) || !patients.count(patId)) { cout << "Error: Invalid IDs.\n"; return; }
-        adjList[docId].push_back(patId);
-        adjList[patId].push_back(docId);
-        cout << "Network: Linked Doctor and Patient.\n";
-    }
-
-    void addMedicalRecord(const string& patId, const string& docId, const string& date, const string& sym, const string& dx, const string& px) {
-        if (!patients.count(patId)) { cout << "Error: Patient not found.\n"; return; }
-        Patient* p = patients[patId];
-        MedicalRecord* newRec = new MedicalRecord(date, sym, dx, px, docId);
+const BatchOpInfo batchOps[OP_COUNT] = {
+    {"doctor", 3}, {"patient", 2}, {"link", 2}, {"record", 6},
+    {"history", 1}, {"search", 1}, {"path", 2}, {"audit", 2}, {"db", 0}
+};
 
-        if (!p->historyHead) {
-            p->historyHead = newRec;
-            p->historyTail = newRec;
-        } else {
-            p->historyTail->next = newRec;
-            newRec->prev = p->historyTail;
-            p->historyTail = newRec;
+int runBatch(EHRSystem& ehr, istream& in) {
+    // Parse the whole stream up front so execution is a tight loop over commands.
+    string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    vector<BatchCommand> commands;
+    int errors = 0;
+    size_t lineNo = 0;
+    for (size_t pos = 0; pos < text.size(); ) {
+        size_t end = text.find('\n', pos);
+        if (end == string::npos) end = text.size();
+        size_t len = end - pos;
+        if (len > 0 && text[end - 1] == '\r') len--;
+        size_t start = pos;
+        pos = end + 1;
+        lineNo++;
+        if (len == 0 || text[start] == '#') continue;
+
+        vector<string> fields;
+        for (size_t f = start, stop = start + len; ; ) {
+            size_t bar = text.find('|', f);
+            if (bar == string::npos || bar > stop) bar = stop;
+            fields.emplace_back(text, f, bar - f);
+            if (bar == stop) break;
+            f = bar + 1;
         }
-        cout << "Record added to history.\n";
-    }
 
-    void displayPatientHistory(const string& patId) {
-        if (!patients.count(patId)) { cout << "Patient not found.\n"; return; }
-        Patient* p = patients[patId];
-        cout << "\n--- History: " << p->name << " ---\n";
-        MedicalRecord* cur = p->historyHead;
-        while (cur) {
-            cout << "Date: " << cur->date << " | Doc: " << cur->doctorId << "\n";
-            cout << "Sym: " << cur->symptoms << " | Dx: " << cur->diagnosis << " | Rx: " << cur->prescription << "\n";
-            cout << "--------------------------------\n";
-            cur = cur->next;
+        int op = 0;
+        while (op < OP_COUNT && fields[0] != batchOps[op].name) op++;
+        if (op == OP_COUNT) {
+            cerr << "Error: line " << lineNo << ": unknown command '" << fields[0] << "'\n";
+            errors++;
+            continue;
+        }
+        if (fields.size() - 1 != batchOps[op].arity) {
+            cerr << "Error: line " << lineNo << ": '" << fields[0] << "' expects " << batchOps[op].arity << " fields\n";
+            errors++;
+            continue;
         }
+        fields.erase(fields.begin());
+        commands.push_back({static_cast<BatchOp>(op), move(fields), lineNo});
     }
 
-    void searchBySymptom(const string& keyword) {
-        cout << "\n--- Search Results: " << keyword << " ---\n";
-        bool found = false;
-        for (auto const& [id, p] : patients) {
-            MedicalRecord* cur = p->historyHead;
-            while (cur) {
-                if (smartSearch(cur->symptoms, keyword)) {
-                    cout << "Match: " << p->name << " (ID: " << p->id << ") - " << cur->symptoms << "\n";
-                    found = true;
-                    break; 
-                }
-                cur = cur->next;
-            }
+    // Command output is collected in memory and written out in large chunks.
+    string buffer;
+    auto flushBuffer = [&]() {
+        cout.write(buffer.data(), buffer.size());
+        buffer.clear();
+    };
+
+    struct OpStats { size_t count = 0; double totalUs = 0, maxUs = 0; };
+    OpStats stats[OP_COUNT];
+    int failed = 0;
+    for (const BatchCommand& c : commands) {
+        const vector<string>& a = c.args;
+        size_t mark = buffer.size();
+        auto t0 = chrono::steady_clock::now();
+        switch (c.op) {
+            case OP_DOCTOR:  buffer += ehr.addDoctor(a[0], a[1], a[2]); break;
+            case OP_PATIENT: buffer += ehr.addPatient(a[0], a[1]); break;
+            case OP_LINK:    buffer += ehr.linkDoctorPatient(a[0], a[1]); break;
+            case OP_RECORD:  buffer += ehr.addMedicalRecord(a[0], a[1], a[2], a[3], a[4], a[5]); break;
+            case OP_HISTORY: buffer += ehr.getPatientHistory(a[0]); break;
+            case OP_SEARCH:  buffer += ehr.findPatientsByKeyword(a[0]); break;
+            case OP_PATH:    buffer += ehr.findShortestPath(a[0], a[1]); break;
+            case OP_AUDIT:   buffer += ehr.getPatientSnapshot(a[0], ehr.openSnapshotAt(a[1])); break;
+            default:         buffer += ehr.getAllDataInTable(); break;
+        }
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+        // The core reports a failed operation as a result starting with "Error:".
+        if (buffer.compare(mark, 6, "Error:") == 0) {
+            cerr << "Error: line " << c.line << ":" << buffer.substr(mark + 6) << "\n";
+            failed++;
         }
-        if (!found) cout << "No matches found.\n";
+        buffer += '\n';
+        OpStats& st = stats[c.op];
+        st.count++;
+        st.totalUs += us;
+        st.maxUs = max(st.maxUs, us);
+        if (buffer.size() > (1 << 20)) flushBuffer();
     }
-
-    void showDatabase() {
-        cout << "\n--- Doctors ---\n";
-        for (auto const& [id, d] : doctors) cout << id << ": " << d->name << " (" << d->specialization << ")\n";
-        cout << "\n--- Patients ---\n";
-        for (auto const& [id, p] : patients) cout << id << ": " << p->name << "\n";
+    flushBuffer();
+    cout.flush();
+
+    cerr << "\n--- Batch Timing: " << commands.size() << " commands, " << errors << " rejected, " << failed
+         << " failed ---\n";
+    cerr << left << setw(10) << "Command" << right << setw(10) << "Count" << setw(14) << "Total (ms)"
+         << setw(12) << "Avg (us)" << setw(12) << "Max (us)" << "\n";
+    cerr << fixed << setprecision(2);
+    for (int op = 0; op < OP_COUNT; ++op) {
+        const OpStats& st = stats[op];
+        if (!st.count) continue;
+        cerr << left << setw(10) << batchOps[op].name << right << setw(10) << st.count << setw(14) << st.totalUs / 1000
+             << setw(12) << st.totalUs / st.count << setw(12) << st.maxUs << "\n";
     }
+    return errors || failed ? 1 : 0;
+}
 
-    // Developer: Harsimran (Dijkstra's Algorithm)
-    void findShortestReferralPath(const string& startId, const string& endId) {
-        if (adjList.find(startId) == adjList.end() || adjList.find(endId) == adjList.end()) {
-            cout << "Error: IDs not found in network.\n";
-            return;
-        }
-
-        set<pair<int, string>> pq;
-        unordered_map<string, int> dist;
-        unordered_map<string, string> parent;
-
-        for (auto const& [key, val] : adjList) dist[key] = numeric_limits<int>::max();
-
-        dist[startId] = 0;
-        pq.insert({0, startId});
-
-        while (!pq.empty()) {
-            string u = pq.begin()->second;
-            pq.erase(pq.begin());
+void printUsage(const char* prog) {
+    cerr << "Usage: " << prog << " [--batch FILE|-] [--cdc-sink FILE] [--cdc-replay FILE]\n";
+}
 
-            if (u == endId) break;
+int main(int argc, char* argv[]) {
+    EHRSystem ehr;
 
-            for (const string& v : adjList[u]) {
-                if (dist[u] + 1 < dist[v]) {
-                    pq.erase({dist[v], v});
-                    dist[v] = dist[u] + 1;
-                    parent[v] = u;
-                    pq.insert({dist[v], v});
-                }
-            }
+    // --cdc-sink FILE appends every change event to FILE; --cdc-replay FILE prints a log and exits.
+    // --batch FILE (or - for stdin) runs commands headlessly instead of the menu.
+    string batchPath, sinkPath, replayPath;
+    for (int i = 1; i < argc; i += 2) {
+        string flag = argv[i];
+        string* value = flag == "--batch" ? &batchPath
+                      : flag == "--cdc-sink" ? &sinkPath
+                      : flag == "--cdc-replay" ? &replayPath : nullptr;
+        if (!value) {
+            cerr << "Error: unknown option '" << flag << "'\n";
+            printUsage(argv[0]);
+            return 2;
         }
-
-        if (dist[endId] == numeric_limits<int>::max()) {
-            cout << "No connection exists between these two.\n";
-            return;
+        if (i + 1 >= argc || argv[i + 1][0] == '\0') {
+            cerr << "Error: " << flag << " needs a file argument\n";
+            printUsage(argv[0]);
+            return 2;
         }
+        *value = argv[i + 1];
+    }
 
-        vector<string> path;
-        string curr = endId;
-        while (curr != startId) {
-            path.push_back(curr);
-            curr = parent[curr];
-        }
-        path.push_back(startId);
-        reverse(path.begin(), path.end());
+    if (!replayPath.empty()) {
+        static const char* typeNames[] = {"?", "ADD_DOCTOR", "ADD_PATIENT", "LINK", "ADD_RECORD"};
+        size_t n = CdcFeed::replay(replayPath, [](const CdcEvent& e) {
+            cout << "v" << e.version << " " << typeNames[e.type <= CDC_ADD_RECORD ? e.type : 0];
+            for (const string& f : e.fields()) cout << " | " << f;
+            cout << "\n";
+        });
+        cout << n << " events replayed.\n";
+        return 0;
+    }
+    if (!sinkPath.empty() && !ehr.changeFeed().startFileSink(sinkPath)) {
+        cerr << "Error: Cannot open CDC sink " << sinkPath << "\n";
+        return 1;
+    }
 
-        cout << "\n--- Shortest Network Path (Dijkstra) ---\n";
-        cout << "Hops: " << dist[endId] << "\n";
-        for (size_t i = 0; i < path.size(); ++i) {
-            string name = doctors.count(path[i]) ? doctors[path[i]]->name : patients[path[i]]->name;
-            string role = doctors.count(path[i]) ? "[Dr]" : "[Pat]";
-            cout << (i==0 ? "" : " -> ") << role << " " << name;
-        }
-        cout << "\n";
+    if (!batchPath.empty()) {
+        if (batchPath == "-") return runBatch(ehr, cin);
+        ifstream script(batchPath, ios::binary);
+        if (!script) { cerr << "Error: Cannot open batch file " << batchPath << "\n"; return 1; }
+        return runBatch(ehr, script);
     }
-};
 
-void clearBuffer() {
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-}
+    auto show = [](const string& msg) { cout << msg << "\n"; };
 
-int main() {
-    EHRSystem ehr;
-    
     // Sample Data
-    ehr.addDoctor("D001", "Ronith", "Cardiologist");
-    ehr.addDoctor("D002", "Harsimran", "Dermatologist");
-    ehr.addDoctor("D003", "Aryan", "Neurologist");
-    ehr.addPatient("P101", "Kapish");
-    ehr.addPatient("P102", "Medhansh");
-    ehr.addPatient("P103", "John");
+    show(ehr.addDoctor("D001", "Ronith", "Cardiologist"));
+    show(ehr.addDoctor("D002", "Harsimran", "Dermatologist"));
+    show(ehr.addDoctor("D003", "Aryan", "Neurologist"));
+    show(ehr.addPatient("P101", "Kapish"));
+    show(ehr.addPatient("P102", "Medhansh"));
+    show(ehr.addPatient("P103", "John"));
+
+    show(ehr.linkDoctorPatient("D001", "P101")); // Ronith - Kapish
+    show(ehr.linkDoctorPatient("D002", "P101")); // Harsimran - Kapish
+    show(ehr.linkDoctorPatient("D002", "P102")); // Harsimran - Medhansh
+    show(ehr.linkDoctorPatient("D003", "P102")); // Aryan - Medhansh
+    show(ehr.linkDoctorPatient("D003", "P103")); // Aryan - John
 
-    ehr.linkDoctorPatient("D001", "P101"); // Ronith - Kapish
-    ehr.linkDoctorPatient("D002", "P101"); // Harsimran - Kapish
-    ehr.linkDoctorPatient("D002", "P102"); // Harsimran - Medhansh
-    ehr.linkDoctorPatient("D003", "P102"); // Aryan - Medhansh
-    ehr.linkDoctorPatient("D003", "P103"); // Aryan - John
-    
-    ehr.addMedicalRecord("P101", "D001", "2025-10-20", "Chest Pain", "Angina", "Aspirin");
+    show(ehr.addMedicalRecord("P101", "D001", "2025-10-20", "Chest Pain", "Angina", "Aspirin"));
 
     int choice;
     do {
         cout << "\n=== EHR Console System ===\n";
         cout << "1. Add Doctor\n2. Add Patient\n3. Link Network\n4. Add Record\n";
         cout << "5. View History\n6. Search Symptoms\n7. Show Database\n";
-        cout << "8. Referral Path Finder (Dijkstra)\n0. Exit\nChoice: ";
+        cout << "8. Referral Path Finder (Dijkstra)\n9. Point-in-Time Audit\n0. Exit\nChoice: ";
         cin >> choice;
         clearBuffer();
 
@@ -236,17 +221,17 @@ int main() {
                 cout << "ID: "; getline(cin, id);
                 cout << "Name: "; getline(cin, name);
                 cout << "Spec: "; getline(cin, spec);
-                ehr.addDoctor(id, name, spec);
+                show(ehr.addDoctor(id, name, spec));
                 break;
             case 2:
                 cout << "ID: "; getline(cin, id);
                 cout << "Name: "; getline(cin, name);
-                ehr.addPatient(id, name);
+                show(ehr.addPatient(id, name));
                 break;
             case 3:
                 cout << "Doc ID: "; getline(cin, doc);
                 cout << "Pat ID: "; getline(cin, pat);
-                ehr.linkDoctorPatient(doc, pat);
+                show(ehr.linkDoctorPatient(doc, pat));
                 break;
             case 4:
                 cout << "Pat ID: "; getline(cin, pat);
@@ -255,23 +240,28 @@ int main() {
                 cout << "Sym: "; getline(cin, sym);
                 cout << "Dx: "; getline(cin, dx);
                 cout << "Rx: "; getline(cin, rx);
-                ehr.addMedicalRecord(pat, doc, dt, sym, dx, rx);
+                show(ehr.addMedicalRecord(pat, doc, dt, sym, dx, rx));
                 break;
             case 5:
                 cout << "Pat ID: "; getline(cin, pat);
-                ehr.displayPatientHistory(pat);
+                show(ehr.getPatientHistory(pat));
                 break;
             case 6:
                 cout << "Keyword: "; getline(cin, sym);
-                ehr.searchBySymptom(sym);
+                show(ehr.findPatientsByKeyword(sym));
                 break;
             case 7:
-                ehr.showDatabase();
+                show(ehr.getAllDataInTable());
                 break;
             case 8: // Dijkstra Feature
                 cout << "Start ID: "; getline(cin, doc);
                 cout << "End ID: "; getline(cin, pat);
-                ehr.findShortestReferralPath(doc, pat);
+                show(ehr.findShortestPath(doc, pat));
+                break;
+            case 9:
+                cout << "Pat ID: "; getline(cin, pat);
+                cout << "As of UTC (YYYY-MM-DD, blank = now): "; getline(cin, dt);
+                show(ehr.getPatientSnapshot(pat, dt.empty() ? ehr.openSnapshot() : ehr.openSnapshotAt(dt)));
                 break;
             case 0: cout << "Exiting...\n"; break;
         }